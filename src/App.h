@@ -7,6 +7,7 @@ extern "C" {
 
 #include <vector>
 #include "Simulation.h"
+#include "NodeSet.h"
 
 class Task;
 class AppClass;
@@ -15,7 +16,7 @@ class Simulation;
 class App {
 public:
     AppClass        *app_class;
-    std::vector<int> nodes;
+    NodeRanges       nodes;
     int              nb_nodes;
     simt_t           start_date;
     simt_t           end_date;
@@ -26,7 +27,24 @@ public:
     simt_t           date_start_work;
     simt_t           remaining_io;
     double           current_iorate;
+    double           work_rate;          /* Progress per unit of time while working */
+    simt_t           work_remaining_at_snapshot;
+    double           ckpt_cost;          /* Estimated duration of a started checkpoint */
+    double           ckpt_delay;         /* Estimated wait between request and start of a checkpoint */
+    simt_t           ckpt_request_date;
+    simt_t           ckpt_start_date;
+    std::vector<simt_t> level_ckpt;      /* Last checkpoint of each level below the file system */
+    std::vector<simt_t> level_work;      /* Work remaining at it */
+    unsigned int     nb_ckpts;           /* Checkpoints taken, over all the instances */
+    double           ckpt_volume;        /* Of the file system checkpoint in progress, in full checkpoints */
+    double           chain_volume;       /* Of the file system checkpoints a restart reads: the last full one and its deltas */
+    unsigned int     chain_length;       /* Checkpoints written in the chain; 0: the next one is full */
+    int              io_level;           /* Of the checkpoint or restart in progress; -1: the file system */
+    simt_t           next_io_work;       /* Work remaining at the next in-run I/O phase; UNDEFINED_DATE: none */
+    simt_t           ckpt_after_io;      /* Work from the I/O phase in progress to the checkpoint it came before; UNDEFINED_DATE: none */
+    bool             io_phase;           /* Doing an in-run I/O phase */
     bool             working;
+    bool             restarting;         /* Instance started by a failure, until it works again */
     png_byte         r, g, b;
     int              app_index;
     int              instance_index;
@@ -35,9 +53,21 @@ public:
 
     App(AppClass *_ac, unsigned int *seed);
     App(App* restarting_app);
+    App(int _app_index, int _instance_index, int _nb_nodes);
     void clear(unsigned int *seed);
 
     simt_t ckpt_interval(void);
+    simt_t next_ckpt_date(simt_t now, simt_t interval);
+    int ckpt_level(unsigned int k) const;
+    simt_t level_time(int level) const;
+    double mean_ckpt_time(void) const;
+    bool next_ckpt_full(void) const;
+    double next_ckpt_volume(simt_t date) const;
+    void prepare_ckpt(simt_t date);
+    bool survives(int level, int first, int count) const;
+    void select_restart(int first, int count);
+    void plan_io_phase(void);
+    simt_t io_phases_time(void) const;
     
     void start_working(simt_t now);
 
@@ -50,6 +80,8 @@ public:
     void removetask(Task *task);
     void removealltasks(simt_t date);
     
+    void checkpoint_requested(simt_t date);
+    void checkpoint_started(simt_t date);
     void checkpoint_success(simt_t date);
         
     void set_random_color(void);
@@ -13,8 +13,14 @@ public:
     simt_t           input_time;
     simt_t           output_time;
     simt_t           _wall_time;
-    simt_t           io_time;
+    simt_t           io_time;            /* Of all the in-run I/O of an app */
+    simt_t           io_period;          /* Work between two in-run I/O phases; 0: no phase */
+    simt_t           io_phase_time;      /* Of one phase: its share of io_time */
     simt_t           ckpt_time;
+    double           compression;        /* Raw over written size of the checkpoints; <= 1: not compressed */
+    simt_t           compress_time;      /* To (de)compress a full checkpoint on the nodes of an app; 0: free */
+    simt_t           dirty_time;         /* Work after which a delta holds 1-1/e of the checkpoint; 0: no delta */
+    unsigned int     full_every;         /* Checkpoints per chain: a full one and its deltas; <= 1: no delta */
     double           target_resource;
     png_byte         r1, g1, b1;
     png_byte         r2, g2, b2;
@@ -28,6 +34,12 @@ public:
              simt_t _ct,
              double _tr);
 
+    void set_io_period(simt_t period);
+    void set_ckpt_volume(double ratio, double compress_rate, simt_t dirty, unsigned int every);
+    bool incremental(void) const { return full_every > 1 && dirty_time > 0; }
+    simt_t ckpt_write_time(double volume) const;
+    simt_t ckpt_io_time(double volume) const;
+
     friend std::ostream& operator<< (std::ostream& stream, const AppClass& ac);
 };
 
@@ -0,0 +1,54 @@
+#ifndef EventQueue_h
+#define EventQueue_h
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+class Task;
+
+/** EventQueue
+ *    Indexed 4-ary min-heap of the tasks of a simulation. Tasks are ordered
+ *    by date, and tasks of the same date in the order in which they were
+ *    queued (the order of the std::multimap this replaces).
+ *    Each task remembers its position in the heap, so that it can be
+ *    removed or moved to another date in O(log n), without a search.
+ */
+class EventQueue {
+public:
+    typedef enum { PUSH, POP, REMOVE, UPDATE } op_type_t;
+    typedef struct {
+        op_type_t type;
+        const Task *task;
+        int64_t date;
+    } op_t;
+
+    /* When set, every operation on any queue of this thread is appended
+     * to it (see qbench.C) */
+    static thread_local std::vector<op_t> *recorder;
+
+    std::vector<Task *> heap;
+    uint64_t next_seq;
+
+    EventQueue();
+    ~EventQueue();
+
+    bool empty(void) const { return heap.empty(); }
+    size_t size(void) const { return heap.size(); }
+    Task *top(void) const { return heap.front(); }
+
+    void push(Task *task);
+    Task *pop(void);
+    void remove(Task *task);
+    void update(Task *task);
+    bool contains(const Task *task) const;
+    void clear(void);
+
+private:
+    bool before(const Task *a, const Task *b) const;
+    void place(Task *task, size_t pos);
+    void sift_up(size_t pos);
+    void sift_down(size_t pos);
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef FaultModel_h
+#define FaultModel_h
+
+#include <stdint.h>
+#include <vector>
+#include <iostream>
+#include "Simulation.h"
+
+/** FaultModel
+ *    Generates the faults of a system, in batches of BATCH faults. Fault i
+ *    of the stream of a seed only depends on the seed and on i (its random
+ *    numbers come from a counter-based generator, Philox4x32-10): every
+ *    strategy simulated with a seed sees the same faults, whatever it does
+ *    between them, and the batch is generated in tight loops out of the
+ *    event loop.
+ *    By default, a fault hits one node, uniformly; with a group_size, it
+ *    hits the whole aligned group of nodes (a blade, a rack) of this node
+ *    with probability group_probability.
+ *    Models are only read once built, so concurrent runs can share one.
+ */
+class FaultModel {
+public:
+    typedef struct {
+        simt_t date;
+        int node;       /* First node */
+        int nb_nodes;   /* Number of consecutive nodes that fail */
+    } fault_t;
+
+    static const unsigned int BATCH = 256;
+
+    int group_size;
+    double group_probability;
+
+    FaultModel() : group_size(1), group_probability(0.0) {}
+    virtual ~FaultModel() {}
+
+    void correlate(int size, double probability) { group_size = size; group_probability = probability; }
+
+    /* Appends batch index of the stream of seed to out, the faults of a
+     * system of nb_nodes with a mean time between faults of mtbf (in ms),
+     * that follow date after (the last fault of the previous batch).
+     * Returns false once the stream has no more faults. */
+    virtual bool batch(unsigned int seed, uint64_t index, simt_t after, int nb_nodes, simt_t mtbf,
+                       std::vector<fault_t> &out) const;
+
+    virtual void print(std::ostream &o) const = 0;
+    friend std::ostream& operator<< (std::ostream& stream, const FaultModel& fm);
+
+    /* Four uniform numbers in (0, 1) for counter ctr of key */
+    static void philox(uint64_t ctr, uint32_t key, double u[4]);
+
+protected:
+    /* Fills dt with the n times between faults drawn from the uniforms u */
+    virtual void interarrivals(const double *u, double *dt, unsigned int n, double mtbf) const = 0;
+};
+
+/** FaultStream
+ *    The faults of a model for a system and a seed, in date order, one
+ *    batch at a time
+ */
+class FaultStream {
+public:
+    const FaultModel &model;
+    unsigned int seed;
+    int nb_nodes;
+    simt_t mtbf;
+    std::vector<FaultModel::fault_t> faults;  /* Current batch */
+    size_t next_fault;
+    uint64_t next_batch;
+    bool ended;
+
+    FaultStream(const FaultModel &_model, unsigned int _seed, int _nb_nodes, simt_t _mtbf) :
+        model(_model),
+        seed(_seed),
+        nb_nodes(_nb_nodes),
+        mtbf(_mtbf),
+        faults(),
+        next_fault(0),
+        next_batch(0),
+        ended(false) {}
+
+    /* Next fault into f; false once there are no more */
+    bool next(FaultModel::fault_t &f);
+};
+
+/** ExponentialFaults
+ *    Faults of a Poisson process: the model under which the checkpoint
+ *    intervals are computed
+ */
+class ExponentialFaults : public FaultModel {
+public:
+    void print(std::ostream &o) const;
+protected:
+    void interarrivals(const double *u, double *dt, unsigned int n, double mtbf) const;
+};
+
+/** WeibullFaults
+ *    Times between faults that follow a Weibull distribution of the given
+ *    shape, with the same mean: a shape below 1 clusters the faults in time
+ */
+class WeibullFaults : public FaultModel {
+public:
+    double shape;
+
+    WeibullFaults(double _shape) : FaultModel(), shape(_shape) {}
+    void print(std::ostream &o) const;
+protected:
+    void interarrivals(const double *u, double *dt, unsigned int n, double mtbf) const;
+};
+
+/** LogFaults
+ *    Faults read from a log: one fault per line, its date in seconds, its
+ *    first node and optionally its number of nodes ('#' starts a comment).
+ *    The stream is the same for all seeds, and ignores the MTBF.
+ */
+class LogFaults : public FaultModel {
+public:
+    std::string filename;
+    std::vector<fault_t> faults;  /* Sorted by date */
+
+    LogFaults(const char *_filename);
+    bool batch(unsigned int seed, uint64_t index, simt_t after, int nb_nodes, simt_t mtbf,
+               std::vector<fault_t> &out) const;
+    void print(std::ostream &o) const;
+protected:
+    void interarrivals(const double *u, double *dt, unsigned int n, double mtbf) const;
+};
+
+#endif
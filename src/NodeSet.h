@@ -0,0 +1,96 @@
+#ifndef NodeSet_h
+#define NodeSet_h
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+/** NodeRanges
+ *    Nodes of an application, as runs of consecutive nodes: the scheduler
+ *    hands out the first free nodes, so an application of thousands of
+ *    nodes usually holds a handful of runs. Nodes must be appended in
+ *    increasing order.
+ */
+class NodeRanges {
+public:
+    typedef struct {
+        int first;
+        int count;
+    } range_t;
+
+    std::vector<range_t> ranges;
+    int nb;
+
+    class const_iterator {
+        const range_t *r;
+        int offset;
+    public:
+        const_iterator(const range_t *_r) : r(_r), offset(0) {}
+        int operator*() const { return r->first + offset; }
+        const_iterator &operator++() {
+            if( ++offset == r->count ) {
+                r++;
+                offset = 0;
+            }
+            return *this;
+        }
+        bool operator!=(const const_iterator &o) const { return r != o.r || offset != o.offset; }
+    };
+
+    NodeRanges() :
+        ranges(),
+        nb(0) {}
+
+    int size(void) const { return nb; }
+    bool empty(void) const { return nb == 0; }
+    void clear(void) { ranges.clear(); nb = 0; }
+    const_iterator begin(void) const { return const_iterator(ranges.data()); }
+    const_iterator end(void) const { return const_iterator(ranges.data() + ranges.size()); }
+
+    void push_back(int n) {
+        if( !ranges.empty() && ranges.back().first + ranges.back().count == n )
+            ranges.back().count++;
+        else
+            ranges.push_back({n, 1});
+        nb++;
+    }
+    bool contains(int n) const;
+};
+
+/** NodeSet
+ *    Set of nodes of the system, packed 64 nodes per word, so that the
+ *    occupation of several scheduling events can be combined with whole
+ *    word (vectorizable) operations instead of one node at a time.
+ */
+class NodeSet {
+public:
+    std::vector<uint64_t> words;
+    int nb_nodes;
+
+    NodeSet() :
+        words(),
+        nb_nodes(0) {}
+
+    NodeSet(int _nb_nodes) :
+        words((_nb_nodes + 63) / 64, 0),
+        nb_nodes(_nb_nodes) {}
+
+    int size(void) const { return nb_nodes; }
+
+    bool test(int n) const { return (words[n >> 6] >> (n & 63)) & 1; }
+    void set(int n)        { words[n >> 6] |= (uint64_t)1 << (n & 63); }
+    void reset(int n)      { words[n >> 6] &= ~((uint64_t)1 << (n & 63)); }
+
+    void set(const NodeRanges &nodes);
+    void reset(const NodeRanges &nodes);
+    bool all(const NodeRanges &nodes) const;
+    bool none(const NodeRanges &nodes) const;
+
+    int count(void) const;
+    int count(int first, int last) const;
+    void merge(const NodeSet &other);
+    int first_free(int nb, NodeRanges &nodes) const;
+    int first_free(int nb, int first, int last, std::vector<int> &nodes) const;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef Profile_h
+#define Profile_h
+
+#include <stdint.h>
+#include <time.h>
+#include <iostream>
+
+/** Profile
+ *    Counters of where a simulation spends its time. Nothing is counted
+ *    unless Profile::current points to a Profile: the instrumented code
+ *    only tests that pointer, and reads the clock when it is set.
+ *    Per thread, like Debug, so that each worker of a Sweep profiles its
+ *    own runs. Section times are inclusive (reschedule_apps includes the
+ *    app_fits it calls).
+ */
+class Profile {
+public:
+    typedef enum { STEP, UPDATE_SCHED_EVENT, RESCHEDULE_APPS, APP_FITS, NB_SECTIONS } section_t;
+
+    static thread_local Profile *current;
+
+    uint64_t count[NB_SECTIONS];
+    uint64_t ns[NB_SECTIONS];
+    uint64_t nb_task_allocs;  /* Tasks created */
+    uint64_t nb_pool_chunks;  /* Chunks of tasks requested from the system allocator */
+    uint64_t nb_sched_events; /* Scheduling events created */
+
+    Profile();
+    void clear(void);
+    void print(std::ostream &o, const std::string &prefix) const;
+
+    static const char *name(section_t s);
+    static long peak_rss_kb(void);
+
+    static uint64_t now(void) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+    }
+
+    /* Counts one occurrence of an event, when profiling */
+    static void incr(uint64_t Profile::*counter) {
+        if( nullptr != current )
+            current->*counter += 1;
+    }
+
+    /** Section
+     *    Times its scope as one occurrence of section, when profiling
+     */
+    class Section {
+        section_t section;
+        uint64_t start;
+    public:
+        Section(section_t s) : section(s), start(nullptr != current ? now() : 0) {}
+        ~Section() {
+            if( nullptr != current && 0 != start ) {
+                current->count[section]++;
+                current->ns[section] += now() - start;
+            }
+        }
+    };
+};
+
+#endif
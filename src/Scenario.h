@@ -0,0 +1,154 @@
+#ifndef Scenario_h
+#define Scenario_h
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <iostream>
+#include "Simulation.h"
+#include "System.h"
+#include "Schedule.h"
+
+class FaultModel;
+class Snapshot;
+
+/** Scenario
+ *    A study: systems and their app classes, the strategies compared on
+ *    each of them, the system parameters swept, the seeds, how the runs
+ *    are measured and where their results go. A driver builds it from its
+ *    options (celio) or reads it from a configuration file (scenario).
+ *    Its plan has one run per system, sweep point, seed and strategy; the
+ *    strategies of a system, point and seed but the baseline start from a
+ *    snapshot of the same workload, and all the runs go through a Sweep.
+ */
+class Scenario {
+public:
+    /* Same order as the strategy numbers of the record and render files */
+    typedef enum { BASELINE, COOP, FCFS, BLOCKING_FCFS, NO, SIMPLE, FAIR_SHARE, BURST_BUFFER, LOOKAHEAD,
+                   ROUTED } kind_t;
+
+    typedef struct {
+        int nb_cores;
+        double input;    /* Fractions of the memory of the app */
+        double output;
+        double wall;     /* Seconds */
+        double io;
+        double ckpt;
+        double target;   /* Fraction of the system */
+        double io_period; /* Seconds of work between in-run I/O phases; 0: none */
+        double compression;    /* Raw over written size of the checkpoints; <= 1: none */
+        double compress_rate;  /* Bytes/s per node; 0: free */
+        double dirty_time;     /* Seconds of work for a delta to hold 1-1/e of the memory; 0: no delta */
+        unsigned int full_every;  /* Checkpoints per chain of a full one and its deltas; <= 1: no delta */
+    } class_spec_t;
+
+    typedef struct {
+        std::string name;
+        int nb_nodes;
+        int cores_per_node;
+        double bandwidth;       /* Bytes/s */
+        double mem_per_node;    /* Bytes */
+        double mtbf;            /* Of the system, in seconds */
+        std::shared_ptr<const FaultModel> fault_model;  /* Null: exponential faults */
+        double ckpt_interval;   /* Seconds; -1: Daly (or adaptive) */
+        double adaptive_weight;
+        double stagger_window;
+        double snapshot_fraction;  /* Negative: blocking checkpoints */
+        double overlap_slowdown;
+        std::vector<System::ckpt_level_t> ckpt_levels;
+        unsigned int pfs_every;
+        int router_nodes;        /* Nodes per I/O router; 0: no routers */
+        double router_bandwidth; /* Bytes/s of the link of a router */
+        System::placement_t placement;
+        std::vector<class_spec_t> classes;
+    } system_spec_t;
+
+    typedef struct {
+        std::string name;       /* In the results */
+        kind_t kind;
+        SimFairShareInterference::sharing_t sharing;  /* Fair share, burst buffers and routed */
+        double node_cap;
+        double ckpt_priority;
+        double bb_capacity;
+        double bb_bandwidth;
+        bool bb_shared;
+        double drain_priority;
+        double lookahead_horizon;     /* Seconds */
+        unsigned int lookahead_depth;
+        double lookahead_advance;
+        unsigned long lookahead_budget;
+    } strategy_spec_t;
+
+    /* A swept parameter of the systems or strategies, and its values */
+    typedef struct {
+        std::string parameter;
+        std::vector<double> values;
+    } sweep_t;
+
+    /* Values of the swept parameters */
+    typedef std::vector<std::pair<std::string, double> > point_t;
+
+    typedef struct {
+        unsigned int system;    /* Indexes in systems, points() and strategies */
+        unsigned int point;
+        unsigned int seed;
+        unsigned int strategy;
+    } run_t;
+
+    std::vector<system_spec_t> systems;
+    std::vector<strategy_spec_t> strategies;
+    std::vector<sweep_t> sweeps;
+    std::vector<unsigned int> seeds;
+
+    /* Measurement, in seconds: the stats of a run cover segment_size after
+     * ignore_start (and before the last ignore_end of the shortest run) */
+    double segment_size;
+    double ignore_start;
+    double ignore_end;
+    double horizon;             /* Of the runs, in shortest runs */
+    unsigned int nb_windows;    /* Streamed measurement windows; 0: one measure */
+    double tolerance;           /* Stop once the waste ratio is known within it; 0: never */
+    double batch_length;
+    bool incremental;
+    double model_max_waste;     /* Skip the points the analytic model puts above it; 0: run all */
+
+    /* Sinks */
+    bool header;                /* Print the systems and their classes */
+    bool profile;
+    bool model;                 /* Print the waste of the analytic model in the header */
+    std::string record_prefix;  /* Empty: no recording */
+    bool record_compressed;
+    std::string render_prefix;  /* Empty: no rendering */
+    Schedule::render_t render;
+
+    Scenario();
+
+    /* Reads a configuration file; throws a runtime_error at file:line on errors */
+    void read(const std::string &filename);
+
+    static system_spec_t default_system(void);
+    static strategy_spec_t default_strategy(kind_t kind);
+    static bool is_parameter(const std::string &parameter);
+
+    double min_run(void) const { return 1.2 * segment_size + ignore_end + ignore_start; }
+    std::vector<point_t> points(void) const;
+    /* Waste of a system at a point, according to the analytic model (WasteModel) */
+    double model_waste(unsigned int system, const point_t &point) const;
+    std::vector<run_t> plan(void) const;
+    /* Runs the plan with jobs workers (0: one per hardware thread); the
+     * results go to o in the order of the plan */
+    void run(unsigned int jobs, std::ostream &o) const;
+
+    /* The system of a run, with the checkpoint interval of its kind of strategy */
+    System *new_system(unsigned int system, const point_t &point, kind_t kind) const;
+    Simulation *new_simulation(const strategy_spec_t &strategy, Schedule *s, Trace &t, unsigned int seed) const;
+
+private:
+    Snapshot *take_snapshot(const run_t &r, const point_t &point, std::ostream &o) const;
+    void run_strategy(const run_t &r, const point_t &point, bool progress, const Snapshot *snapshot,
+                      std::ostream &o) const;
+    void print_header(unsigned int system, const point_t &point, std::ostream &o) const;
+};
+
+#endif
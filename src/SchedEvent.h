@@ -5,26 +5,45 @@
 #include <vector>
 
 #include "Simulation.h"
+#include "NodeSet.h"
+#include "Profile.h"
 
 class App;
 
 class SchedEvent {
 public:
-    std::set<App*>    apps;
-    std::vector<bool> occ;
+    std::set<App*>    apps;     /* Changed through add and remove only */
+    NodeSet           occ;
 
     SchedEvent() :
         apps(),
-        occ() {}
+        occ(),
+        index() {}
 
     SchedEvent(int nb_nodes) :
         apps(),
-        occ(nb_nodes, false) {}
+        occ(nb_nodes),
+        index() { Profile::incr(&Profile::nb_sched_events); }
 
     SchedEvent(SchedEvent *ev) :
         apps(ev->apps),
-        occ(ev->occ) {}
-
+        occ(ev->occ),
+        index() { Profile::incr(&Profile::nb_sched_events); }
+
+    void add(App *app) { apps.insert(app); index.clear(); }
+    size_t remove(App *app) { index.clear(); return apps.erase(app); }
+    std::set<App*>::iterator remove(std::set<App*>::iterator it) { index.clear(); return apps.erase(it); }
+    App *app_of(int node);
+
+private:
+    typedef struct {
+        int first;
+        int count;
+        App *app;
+    } range_t;
+    /* The node ranges of the apps, by first node; built by app_of, and
+     * emptied when the apps change */
+    std::vector<range_t> index;
 };
 
 #endif
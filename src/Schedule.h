@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "Simulation.h"
+#include "NodeSet.h"
 
 class SchedEvent;
 class System;
@@ -12,20 +13,48 @@ class App;
 
 class Schedule {
 public:
+    /* What Schedule::print renders: the dates from from_date to to_date
+     * (UNDEFINED_DATE for the last scheduling event) in height rows, and
+     * the nodes in width columns (0 for one column per node), in tiles of
+     * rows rendered by nb_threads threads */
+    typedef struct {
+        simt_t from_date;
+        simt_t to_date;
+        int width;
+        int height;
+        unsigned int nb_threads;
+    } render_t;
+
+
     System *s;
     std::map<simt_t, SchedEvent* > scheduling;
+    /* When set, update_sched_event only repairs the part of the schedule
+     * that changed instead of rebuilding everything after the update date */
+    bool incremental;
+    /* Number of calls to update_sched_event, and of pending applications
+     * that were moved (or removed and placed again) by these calls */
+    unsigned long nb_updates;
+    unsigned long nb_moved;
 
     Schedule(System *sys);
     ~Schedule();
     void clear();
-    bool app_fits(App *app, simt_t at_date, std::vector<int> *candidates);
-    bool node_remains_free(int n, simt_t from_date, simt_t to_date);
-    std::vector<int> *app_fits(App *app, simt_t at_date);
+    Schedule *clone(System *sys) const;
+    void schedule_placed_apps();
+    void busy_nodes(simt_t from_date, simt_t to_date, NodeSet &busy);
+    NodeRanges *app_fits(App *app, simt_t at_date);
     void remove_events_at_date(simt_t at_date);
     void reschedule_apps(simt_t at_date);
-    bool all_nodes_busy_between(simt_t start, simt_t end, const std::vector<int> *nodes);
+    void place_app(App *app, std::map<simt_t, SchedEvent* >::iterator se);
+    void unplace_app(App *app);
+    bool move_app_earlier(App *app, simt_t at_date, simt_t before);
+    void backfill(simt_t at_date, simt_t until);
+    void prune_events(simt_t from_date, simt_t to_date);
+    bool all_nodes_busy_between(simt_t start, simt_t end, const NodeRanges *nodes);
     void update_sched_event(App *app, simt_t new_end_date);
     int print(const std::string filename, simt_t at_date);
+    int print(const std::string filename, simt_t at_date, const render_t &r);
+    void render_rows(const render_t &r, simt_t at_date, int first_row, int nb_rows, unsigned char *rows) const;
     void print(std::ostream &o);
 };
 
@@ -6,6 +6,8 @@
 #include <iostream>
 #include <sstream>
 #include <set>
+#include <stdexcept>
+#include <math.h>
 
 typedef int64_t simt_t;
 #define UNDEFINED_DATE ((int64_t)-1)
@@ -15,6 +17,7 @@ typedef int64_t simt_t;
 #include "Schedule.h"
 #include "Task.h"
 #include "Trace.h"
+#include "EventQueue.h"
 
 #include <vector>
 #include <map>
@@ -22,8 +25,9 @@ typedef int64_t simt_t;
 class Debug: public std::ostringstream
 {
 public:
-    static bool debug;
-    static std::ostream *stream;
+    /* Per-thread, so that each worker of a Sweep can trace its own run */
+    static thread_local bool debug;
+    static thread_local std::ostream *stream;
     Debug() = default;
 
     ~Debug()
@@ -43,28 +47,35 @@ class Task;
 class AppTaskIO;
 class Schedule;
 class Trace;
+class FaultStream;
 
 class Simulation {
 public:
-    std::multimap<simt_t, Task*>tasks;
+    EventQueue tasks;
     Schedule *schedule;
     std::vector<AppTaskIO *>io_tasks;
     Trace &trace;
     unsigned int seed_fault;
+    FaultStream *faults;     /* Of the fault model of the system, for seed_fault */
     unsigned int seed_app_order;
     simt_t curdate;
+    bool progress;
+    uint64_t nb_events;
     
     Simulation(Schedule *_sched, Trace &t, unsigned int seed, bool inject_failure = true);
-    virtual ~Simulation() {}
+    virtual ~Simulation();
 
     bool step(void);
-    void inject_next_fault(simt_t from_date);
+    bool run(double max_date);
+    void inject_next_fault(void);
     double cur_date(void);
     simt_t cur_simt(void);
     virtual void start_io(simt_t start_date, App *app) = 0;
     virtual void end_io(simt_t start_date, App *app) = 0;
     virtual bool start_ckpt(simt_t start_date, App *app) = 0;
     virtual void end_ckpt(simt_t start_date, App *app) = 0;
+    /* End of the background copy of a checkpoint to a slower tier */
+    virtual void end_drain(simt_t date, App *app);
     
     virtual void clear_app(App *app,simt_t date);
 };
@@ -107,6 +118,238 @@ public:
     void start_remaining_io(simt_t start_date, App *app, AppTaskIO *task);
 };
 
+/** SimFairShareInterference
+ *    Concurrent I/Os share the bandwidth as a fluid: each gets a share
+ *    proportional to its weight (its number of nodes, or 1 for max-min
+ *    fairness between applications, times ckpt_priority for checkpoints),
+ *    but never more than its cap (node_cap of the bandwidth per node);
+ *    what capped I/Os leave is shared by the others (water-filling).
+ *    Uncapped I/Os progress with one virtual clock, that advances by
+ *    lambda (the rate per unit of weight) per unit of time: the virtual
+ *    date at which each of them ends does not change when lambda does,
+ *    so a rate change only reschedules the end of the first one to end
+ *    (the others wait at PARKED_DATE), and the I/Os that cross their cap.
+ *    The remaining_io and current_iorate of the applications follow each
+ *    rate change.
+ **/
+class SimFairShareInterference : public Simulation {
+public:
+    typedef enum { SHARE_PROPORTIONAL, SHARE_MAX_MIN } sharing_t;
+    static const simt_t PARKED_DATE = INT64_MAX / 4;
+
+    typedef struct {
+        App *app;
+        double weight;
+        double cap;      /* Fraction of the bandwidth, at most */
+        bool capped;
+        double finish;   /* Virtual date of the end if uncapped, date of the end if capped */
+    } flow_t;
+
+    sharing_t sharing;
+    double node_cap;      /* Fraction of the bandwidth one node can use, 0 for no cap */
+    double ckpt_priority; /* Weight of a checkpoint relative to another I/O */
+
+    std::map<AppTaskIO*, flow_t> flows;   /* By the task that ends the transfer */
+    std::map<App*, AppTaskIO*> app_io;   /* Flow of the I/O of each application */
+    std::set<std::pair<double, AppTaskIO*> > by_finish;   /* Uncapped flows, by virtual end */
+    std::set<std::pair<double, AppTaskIO*> > uncapped_by_threshold;
+    std::set<std::pair<double, AppTaskIO*> > capped_by_threshold;
+    double uncapped_weight;  /* Sum of the weights of uncapped flows */
+    double capped_rate;      /* Sum of the caps of capped flows */
+    double vclock;
+    simt_t date_of_last_change;
+    AppTaskIO *head;         /* Uncapped flow whose end is scheduled */
+    unsigned long nb_reschedules;
+
+    SimFairShareInterference(Schedule *_sched, Trace &t, unsigned int seed, bool inject_failure = true,
+                             sharing_t _sharing = SHARE_MAX_MIN, double _node_cap = 0.0, double _ckpt_priority = 1.0) :
+    Simulation(_sched, t, seed, inject_failure),
+        sharing(_sharing),
+        node_cap(_node_cap),
+        ckpt_priority(_ckpt_priority),
+        flows(),
+        app_io(),
+        by_finish(),
+        uncapped_by_threshold(),
+        capped_by_threshold(),
+        uncapped_weight(0.0),
+        capped_rate(0.0),
+        vclock(0.0),
+        date_of_last_change(0),
+        head(nullptr),
+        nb_reschedules(0) {}
+    ~SimFairShareInterference();
+
+    void start_io(simt_t start_date, App *app);
+    void end_io(simt_t start_date, App *app);
+    bool start_ckpt(simt_t start_date, App *app);
+    void end_ckpt(simt_t start_date, App *app);
+
+    void clear_app(App *app, simt_t date);
+
+    double lambda(void) const;
+    double threshold(const flow_t &f) const { return f.cap / f.weight; }
+    void advance(simt_t date);
+    void add_flow(simt_t date, AppTaskIO *task, double remaining, double weight_factor);
+    void remove_flow(simt_t date, AppTaskIO *task);
+    void erase_flow(AppTaskIO *task);
+    void add_io(simt_t date, App *app, AppTaskIO *task, bool checkpoint);
+    void remove_io(simt_t date, App *app);
+    void set_capped(simt_t date, AppTaskIO *task, flow_t &f, bool capped);
+    void rebalance(simt_t date);
+    void update_apps(simt_t date);
+    void reschedule_head(simt_t date);
+};
+
+/** SimRoutedInterference
+ *    The nodes reach the file system through the routers of the system,
+ *    one for each System::group_size consecutive nodes, whose links carry
+ *    System::group_bandwidth each, behind the global bandwidth. The nodes
+ *    of an application share its I/O evenly: the link of a router carries
+ *    the part of the I/O of each application that its nodes hold behind
+ *    it, and the application goes at the pace of its most loaded link.
+ *    The rates are max-min fair over all the links, weighted as in
+ *    SimFairShareInterference (by the nodes of the application with
+ *    SHARE_PROPORTIONAL, times ckpt_priority for checkpoints), computed by
+ *    progressive filling at each start and end of a transfer. Without
+ *    routers, all the I/O only shares the global bandwidth.
+ **/
+class SimRoutedInterference : public Simulation {
+public:
+    typedef struct {
+        App *app;
+        double weight;
+        std::vector<std::pair<int, double> > groups;  /* Router, fraction of the nodes of the app behind it */
+        double rate;     /* Fraction of the bandwidth */
+    } flow_t;
+
+    SimFairShareInterference::sharing_t sharing;
+    double ckpt_priority;  /* Weight of a checkpoint relative to another I/O */
+
+    std::map<AppTaskIO*, flow_t> flows;   /* By the task that ends the transfer */
+    std::map<App*, AppTaskIO*> app_io;
+    simt_t date_of_last_change;
+    unsigned long nb_rebalances;
+    unsigned long nb_rates;          /* Rates set by the rebalances */
+    unsigned long nb_router_bound;   /* Of them, set by a router link rather than the global bandwidth */
+
+    SimRoutedInterference(Schedule *_sched, Trace &t, unsigned int seed, bool inject_failure = true,
+                          SimFairShareInterference::sharing_t _sharing = SimFairShareInterference::SHARE_MAX_MIN,
+                          double _ckpt_priority = 1.0) :
+    Simulation(_sched, t, seed, inject_failure),
+        sharing(_sharing),
+        ckpt_priority(_ckpt_priority),
+        flows(),
+        app_io(),
+        date_of_last_change(0),
+        nb_rebalances(0),
+        nb_rates(0),
+        nb_router_bound(0) {}
+    ~SimRoutedInterference();
+
+    void start_io(simt_t start_date, App *app);
+    void end_io(simt_t start_date, App *app);
+    bool start_ckpt(simt_t start_date, App *app);
+    void end_ckpt(simt_t start_date, App *app);
+
+    void clear_app(App *app, simt_t date);
+    void print_stats(std::ostream &o, const std::string &prefix) const;
+
+private:
+    void transfer(simt_t date);
+    void rebalance(simt_t date);
+    void add_io(simt_t date, App *app, AppTaskIO *task, bool checkpoint);
+    void remove_io(simt_t date, App *app);
+};
+
+/** SimBurstBuffer
+ *    A fast tier between the nodes and the parallel file system: a
+ *    checkpoint whose node share (as written) fits in what the burst
+ *    buffer of a node has left, besides the chain of the last checkpoint
+ *    and the one being drained, is written at the burst buffer bandwidth
+ *    of each node, without interference, then drained to the file system
+ *    in the background. Drains, and the
+ *    checkpoints that do not fit, share the file system bandwidth with
+ *    the other I/O as in SimFairShareInterference, drains with a weight
+ *    of drain_priority. Only the last checkpoint is drained: a newer one
+ *    written meanwhile waits for the current drain, and replaces the
+ *    ones that waited before.
+ *    A restart reads the last checkpoint from the burst buffer if it is
+ *    shared (it survives the failure of a node), from the file system
+ *    if the last checkpoint was drained; otherwise, the application rolls
+ *    back to the last checkpoint that reached the file system (or to its
+ *    beginning), and the work done since is lost. A shared burst buffer
+ *    keeps draining through the failure of the application.
+ **/
+class SimBurstBuffer : public SimFairShareInterference {
+public:
+    typedef struct {
+        simt_t initial_work;
+        simt_t bb_date;      /* Last checkpoint in the burst buffer */
+        simt_t bb_work;      /* Work remaining at it */
+        simt_t pfs_date;     /* Last checkpoint on the file system */
+        simt_t pfs_work;
+        simt_t drain_date;   /* Checkpoint being drained */
+        simt_t drain_work;
+        double bb_volume;    /* Chain a restart from each checkpoint reads, in full checkpoints */
+        double pfs_volume;
+        double drain_volume;
+        bool draining;
+        bool drain_pending;  /* The last checkpoint waits for the current drain */
+    } tiers_t;
+
+    double bb_capacity;    /* Bytes per node */
+    double bb_bandwidth;   /* Bytes per second per node */
+    bool bb_shared;
+    double drain_priority;
+
+    std::map<int, tiers_t> tiers;       /* By application index: a restart keeps its tiers */
+    std::map<App*, AppTaskIO*> drains;  /* Drain of each application instance */
+    std::set<App*> bb_io;               /* Applications reading or writing their burst buffer */
+
+    unsigned long nb_ckpt_bb;
+    unsigned long nb_ckpt_pfs;
+    unsigned long nb_drains;
+    unsigned long nb_restart_bb;
+    unsigned long nb_restart_pfs;
+    unsigned long nb_rollbacks;
+    double lost_work;      /* Node.ms of checkpointed work lost with a burst buffer */
+
+    SimBurstBuffer(Schedule *_sched, Trace &t, unsigned int seed, bool inject_failure = true,
+                   double _bb_capacity = 64e9, double _bb_bandwidth = 2e9, bool _bb_shared = false,
+                   double _drain_priority = 1.0, sharing_t _sharing = SHARE_PROPORTIONAL) :
+    SimFairShareInterference(_sched, t, seed, inject_failure, _sharing),
+        bb_capacity(_bb_capacity),
+        bb_bandwidth(_bb_bandwidth),
+        bb_shared(_bb_shared),
+        drain_priority(_drain_priority),
+        tiers(),
+        drains(),
+        bb_io(),
+        nb_ckpt_bb(0),
+        nb_ckpt_pfs(0),
+        nb_drains(0),
+        nb_restart_bb(0),
+        nb_restart_pfs(0),
+        nb_rollbacks(0),
+        lost_work(0.0) {}
+    ~SimBurstBuffer();
+
+    void start_io(simt_t start_date, App *app);
+    void end_io(simt_t start_date, App *app);
+    bool start_ckpt(simt_t start_date, App *app);
+    void end_ckpt(simt_t start_date, App *app);
+    void end_drain(simt_t date, App *app);
+
+    void clear_app(App *app, simt_t date);
+
+    double bb_bytes(const App *app, double volume) const;
+    bool fits(const App *app) const;
+    simt_t bb_time(const App *app, double volume) const;
+    void start_drain(simt_t date, App *app, tiers_t &t);
+    void print_stats(std::ostream &o, const std::string &prefix) const;
+};
+
 /** SimOrderedIOBlockingFCFS
  *    IO and checkpoint happen in FIFO order, and
  *    checkpoints are blocking
@@ -155,22 +398,53 @@ public:
         App *app;
         simt_t requested_start_date;
         bool checkpoint;
+        simt_t wait_start; /* d(r) of the heuristic is date - wait_start */
         bool operator<(const struct io_request_s &b) const;
     } io_request_t;
 
+    /* How the next I/O is selected: with the aggregates below, with the
+     * heuristic computed from scratch for each request, or with both,
+     * counting the decisions on which they disagree */
+    typedef enum { SELECT_AGGREGATE, SELECT_REFERENCE, SELECT_CHECK } selection_t;
+
     std::set<io_request_t> io_requests;
     AppTaskIO *current_io; /* Can be a START_CKPT to actually start a checkpoint
                             * or END_CKPT / END_IO to know the date of the end of the checkpoint
                             * We don't store anything in io_tasks */
-    
+
+    /* Sums over io_requests, kept up to date by add_request and erase_request,
+     * so that the score of one request is computed in constant time */
+    int64_t ckpt_nodes;      /* sum of nb_nodes over checkpoints */
+    int64_t ckpt_nodes_wait; /* sum of nb_nodes * wait_start over checkpoints */
+    int64_t io_factors;      /* sum of io_factor over I/Os */
+    int64_t io_factors_wait; /* sum of io_factor * (ckpt_time - wait_start) over I/Os */
+
+    selection_t selection;
+    unsigned long nb_selections;
+    unsigned long nb_mismatches;
+
     SimOrderedIOCoop(Schedule *_sched, Trace &t, unsigned int seed, bool inject_failure = true) :
     Simulation(_sched, t, seed, inject_failure),
         io_requests(),
-        current_io(nullptr) {}
+        current_io(nullptr),
+        ckpt_nodes(0),
+        ckpt_nodes_wait(0),
+        io_factors(0),
+        io_factors_wait(0),
+        selection(SELECT_AGGREGATE),
+        nb_selections(0),
+        nb_mismatches(0) {}
     ~SimOrderedIOCoop();
 
-    double heuristic(simt_t date, io_request_t ior);
-    void select_next_io_task(simt_t start_date);
+    double heuristic(simt_t date, const io_request_t &ior);
+    int64_t io_factor(const App *app) const;
+    int64_t weight(simt_t date, const io_request_t &r, simt_t vi) const;
+    int64_t score(simt_t date, const io_request_t &ior) const;
+    void add_request(simt_t date, App *app, bool checkpoint);
+    std::set<io_request_t>::iterator erase_request(std::set<io_request_t>::iterator it);
+    virtual void select_next_io_task(simt_t start_date);
+    void start_request(simt_t date, std::set<io_request_t>::iterator it);
+    void cancel_late_checkpoints(simt_t date, simt_t end_date, const App *best_app);
     
     void start_io(simt_t start_date, App *app);
     void end_io(simt_t start_date, App *app);
@@ -180,4 +454,96 @@ public:
     void clear_app(App *app, simt_t date);
 };
 
+/** SimLookaheadCoop
+ *    The cooperative strategy, but the I/O that starts when the channel
+ *    frees up is chosen by planning the demand known over a horizon: the
+ *    waiting requests, and the checkpoints and I/Os that the working apps
+ *    will request within horizon (their dates are known until a failure).
+ *    A branch and bound search orders depth of these requests on the
+ *    channel, one after the other, to minimize the expected waste: the
+ *    time the nodes of an I/O wait, and the work that a failure would
+ *    lose while a checkpoint waits. A checkpoint due within advance of its
+ *    interval can start early, at the cost of that fraction of one more
+ *    checkpoint. The search stops after budget nodes with the best plan
+ *    found. Only the first request of the plan starts: the rest of the
+ *    plan, minus the requests of the apps that failed since, is the first
+ *    bound of the next search. A search that finds no plan falls back to
+ *    the choice of SimOrderedIOCoop.
+ **/
+class SimLookaheadCoop : public SimOrderedIOCoop {
+public:
+    typedef struct {
+        App *app;
+        bool checkpoint;
+        bool pending;      /* Waiting in io_requests; otherwise, task requests it at ready */
+        Task *task;
+        simt_t ready;
+        simt_t earliest;   /* ready, or the date from which a checkpoint may start early */
+        simt_t duration;
+        simt_t since;      /* Last checkpoint of the app, or its start */
+        simt_t interval;   /* Checkpoint interval of the app */
+        double rate;       /* Failures of the app per ms */
+    } candidate_t;
+
+    simt_t horizon;
+    unsigned int depth;
+    double advance;        /* Fraction of the checkpoint interval */
+    unsigned long budget;  /* Search nodes per decision */
+
+    std::vector<std::pair<App*, bool> > plan;   /* Rest of the last plan: app, checkpoint */
+
+    unsigned long nb_decisions;
+    unsigned long nb_nodes;     /* Search nodes, over all the decisions */
+    unsigned long nb_cut;       /* Searches stopped by the budget */
+    unsigned long nb_kept;      /* Decisions that started the next request of the last plan */
+    unsigned long nb_advanced;  /* Checkpoints started early */
+    unsigned long nb_repairs;   /* Plans that lost requests to a failure */
+    unsigned long nb_fallbacks; /* Searches without a plan, decided as SimOrderedIOCoop */
+    uint64_t planning_ns;
+
+    SimLookaheadCoop(Schedule *_sched, Trace &t, unsigned int seed, bool inject_failure = true,
+                     double _horizon = 3600.0, unsigned int _depth = 6, double _advance = 0.05,
+                     unsigned long _budget = 10000) :
+    SimOrderedIOCoop(_sched, t, seed, inject_failure),
+        horizon(ceil(TIME_UNIT * _horizon)),
+        depth(_depth),
+        advance(_advance),
+        budget(_budget),
+        plan(),
+        nb_decisions(0),
+        nb_nodes(0),
+        nb_cut(0),
+        nb_kept(0),
+        nb_advanced(0),
+        nb_repairs(0),
+        nb_fallbacks(0),
+        planning_ns(0) {
+        if( depth < 1 )
+            throw std::runtime_error("The lookahead must plan at least one request");
+    }
+
+    void select_next_io_task(simt_t start_date);
+    void clear_app(App *app, simt_t date);
+    void print_stats(std::ostream &o, const std::string &prefix) const;
+
+private:
+    typedef struct {
+        const std::vector<candidate_t> *candidates;
+        bool must_start;          /* Something waits: the plan starts an I/O now */
+        simt_t date;
+        std::vector<int> order;
+        std::vector<simt_t> starts;
+        std::vector<bool> used;
+        std::vector<int> best;
+        std::vector<simt_t> best_starts;
+        double best_cost;
+        unsigned long nodes;
+    } search_t;
+
+    std::vector<candidate_t> candidates(simt_t date);
+    double cost(const candidate_t &c, simt_t start) const;
+    void evaluate(search_t &s, const std::vector<int> &order) const;
+    void branch(search_t &s, simt_t free, double cost_so_far) const;
+};
+
 #endif
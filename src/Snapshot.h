@@ -0,0 +1,28 @@
+#ifndef Snapshot_h
+#define Snapshot_h
+
+#include "Simulation.h"
+
+class System;
+class Schedule;
+
+/** Snapshot
+ *    Image of a system (its generated apps) and of its schedule after the
+ *    initial placement. Each restore gives a private copy, from which a
+ *    simulation starts with the same workload, placement and tasks as if
+ *    it had generated and placed them itself (once it is built, call
+ *    Schedule::schedule_placed_apps instead of reschedule_apps(0)).
+ *    Restoring only reads the snapshot, so concurrent runs can share one.
+ */
+class Snapshot {
+public:
+    System *system;
+    Schedule *schedule;
+
+    Snapshot(const System *sys, const Schedule *s);
+    ~Snapshot();
+
+    void restore(System *&sys, Schedule *&s) const;
+};
+
+#endif
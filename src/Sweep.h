@@ -0,0 +1,42 @@
+#ifndef Sweep_h
+#define Sweep_h
+
+#include <functional>
+#include <vector>
+#include <sstream>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+/** Sweep
+ *    Runs a set of independent runs on a pool of worker threads.
+ *    Each run must own all of its state (System, Schedule, Trace and
+ *    Simulation); what it writes to its output stream is buffered and
+ *    emitted in the order in which the runs were added.
+ */
+class Sweep {
+public:
+    typedef std::function<void(std::ostream &)> run_t;
+
+    unsigned int nb_workers;
+    std::vector<run_t> runs;
+    std::vector<std::ostringstream *> outputs;
+    std::vector<bool> done;
+    std::vector<std::exception_ptr> errors;
+    unsigned int next_run;
+    std::mutex lock;
+    std::condition_variable cond;
+
+    Sweep(unsigned int nb_workers);
+    ~Sweep();
+
+    void add(run_t run);
+    void run(std::ostream &o);
+
+    static unsigned int default_workers(void);
+
+private:
+    void worker(bool debug, std::ostream *debug_stream);
+};
+
+#endif
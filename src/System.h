@@ -2,14 +2,28 @@
 #define System_h
 
 #include <vector>
+#include <map>
+#include <memory>
 #include "Simulation.h"
 
 class AppClass;
+class FaultModel;
 class App;
 class Simulation;
 
 class System {
 public:
+    /** A checkpoint level below the file system, written and read by the
+     *  nodes of the app without the file system */
+    /** Where the scheduler puts the nodes of an app among the router groups */
+    typedef enum { PLACE_FIRST, PLACE_PACK, PLACE_SPREAD } placement_t;
+
+    typedef struct {
+        double bandwidth;      /* Bytes/s per node */
+        unsigned int every;    /* Checkpoints of this level: one in every */
+        int partner_distance;  /* 0: kept on its node only; d: also on the node d ranks away in the app */
+    } ckpt_level_t;
+
     const char *name;
     int nb_nodes;
     int cores_per_node;
@@ -18,20 +32,47 @@ public:
     std::vector <AppClass *>classes;
     std::vector <App*>apps;
     simt_t mtbf_ind;
+    std::shared_ptr<const FaultModel> fault_model;  /* Shared by the clones */
     Simulation *sim;
     bool finalized;
+    /* The apps are already placed (restored from a Snapshot): finalize only
+     * attaches the simulation */
+    bool placed;
     int  next_appclass_id;
+    int  next_app_index;
     simt_t fixed_checkpoint_interval;
+    double adaptive_weight;   /* Of the last measure in the checkpoint estimates of an app; 0: nominal Daly */
+    double stagger_window;    /* Fraction of its interval a checkpoint can be delayed by; 0: no staggering */
+    std::multimap<simt_t, simt_t> ckpt_plan;  /* Start and end of the coming checkpoints, when staggering */
+    bool async_ckpt;          /* Apps work while their checkpoints drain */
+    double snapshot_fraction; /* Of the checkpoint time that blocks an asynchronous checkpoint */
+    double overlap_slowdown;  /* Fraction of the work lost while a checkpoint drains */
+    std::vector<ckpt_level_t> ckpt_levels;  /* The cheapest first; the file system is above them */
+    unsigned int pfs_every;   /* Checkpoints that go to the file system: one in pfs_every */
+    int group_size;           /* Consecutive nodes behind one I/O router; 0: no routers */
+    double group_bandwidth;   /* Bytes/s of the link of a router to the file system */
+    placement_t placement;
     simt_t min_duration;
+    std::ostream *log;
     
     System(const char *name, int _nodes, int _cores, double _band, double _mem, simt_t _mtbf_sys, simt_t min_duration);
     ~System();
     void clear();
-    void add_app_class(int nb_cores, double input, double output, simt_t wall, double io, double ckpt, double target);
+    System *clone() const;
+    void add_app_class(int nb_cores, double input, double output, simt_t wall, double io, double ckpt, double target,
+                       double io_period = 0.0);
     void finalize(Simulation *_sim, unsigned int *seed);
     std::pair<int, App*> pick_class(std::vector<AppClass *>&goals, unsigned int *seed);
     void set_fixed_checkpoint_interval(simt_t intvl);
     void set_daly_checkpoint_interval();
+    void set_adaptive_checkpoint_interval(double weight, double stagger);
+    simt_t stagger_ckpt(simt_t now, simt_t date, double cost, simt_t limit);
+    void set_async_checkpoint(double snapshot, double slowdown);
+    void add_ckpt_level(double bandwidth, unsigned int every, int partner_distance);
+    void set_pfs_checkpoint_period(unsigned int every);
+    void set_io_period(double period);
+    void set_router_groups(int size, double bandwidth, placement_t placement);
+    int nb_groups(void) const { return group_size > 0 ? (nb_nodes + group_size - 1) / group_size : 0; }
     
     friend std::ostream& operator<< (std::ostream& stream, const System& sys);
 };
@@ -12,18 +12,27 @@ class Simulation;
 
 class Task {
 public:
-    typedef enum { NODE_FAULT, APP_FAILURE, CKPT_START, CKPT_END, APP_START, APP_END, IO_START, IO_END } type_t;
+    typedef enum { NODE_FAULT, APP_FAILURE, CKPT_START, CKPT_END, APP_START, APP_END, IO_START, IO_END, DRAIN_END, SNAPSHOT_END, IO_PHASE_START } type_t;
+    static const int64_t NOT_QUEUED = -1;
     Simulation *sim;
     type_t type;
     simt_t date;
+    int64_t queue_index;  /* Position in the EventQueue, or NOT_QUEUED */
+    uint64_t queue_seq;   /* Orders the tasks of the same date in the EventQueue */
 
     Task(Simulation *_sim, type_t _type, simt_t _date) :
         sim(_sim),
         type(_type),
-        date(_date) {}
+        date(_date),
+        queue_index(NOT_QUEUED),
+        queue_seq(0) {}
 
     virtual ~Task() { }
 
+    /* Tasks are small and short-lived: they are recycled through per-thread free lists */
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+
     std::string str_type(void) const {
         switch( type ) {
         case Task::NODE_FAULT:
@@ -49,6 +58,12 @@ public:
             break;
         case Task::IO_END:
             return std::string("IO END");
+        case Task::DRAIN_END:
+            return std::string("DRAIN END");
+        case Task::SNAPSHOT_END:
+            return std::string("SNAPSHOT END");
+        case Task::IO_PHASE_START:
+            return std::string("IO PHASE START");
         default:
             return std::string("UKNOWN TYPE");
         }
@@ -63,9 +78,11 @@ public:
 class NodeFaultTask : public Task {
 public:
     int node_id;
-    NodeFaultTask(Simulation *sim, simt_t _date, int _node) :
+    int nb_nodes;   /* Consecutive nodes that fail, from node_id */
+    NodeFaultTask(Simulation *sim, simt_t _date, int _node, int _nb_nodes = 1) :
         Task(sim, Task::NODE_FAULT, _date),
-        node_id(_node) {}
+        node_id(_node),
+        nb_nodes(_nb_nodes) {}
 
     ~NodeFaultTask() { }
 
@@ -102,8 +119,13 @@ public:
 
 class AppFailureTask: public AppTask {
 public:
-    AppFailureTask(Simulation *sim, simt_t _date, App* _app) :
-        AppTask(sim, Task::APP_FAILURE, _date, _app) { }
+    int node_id;    /* Nodes lost, that the checkpoint levels must survive */
+    int nb_nodes;
+
+    AppFailureTask(Simulation *sim, simt_t _date, App* _app, int _node = -1, int _nb_nodes = 0) :
+        AppTask(sim, Task::APP_FAILURE, _date, _app),
+        node_id(_node),
+        nb_nodes(_nb_nodes) { }
 
     ~AppFailureTask() { }
 
@@ -121,6 +143,18 @@ public:
     bool vstep(void);
 };
 
+/* End of the blocking part of an asynchronous checkpoint: the
+ * application works again, slowed down, while its checkpoint drains */
+class SnapshotEndTask: public AppTask {
+public:
+    SnapshotEndTask(Simulation *sim, simt_t _date, App* _app) :
+        AppTask(sim, Task::SNAPSHOT_END, _date, _app)  {  }
+
+    ~SnapshotEndTask() { }
+
+    bool vstep(void);
+};
+
 class AppTaskIO: public AppTask {
 public:
     AppTaskIO(Simulation *sim, Task::type_t type, simt_t _date, App* _app) :
@@ -161,6 +195,20 @@ public:
     bool vstep(void);
 };
 
+/* Start of an in-run I/O phase of the application (analysis or
+ * visualization dumps): it stops working until the I/O ends, as for its
+ * input or output, and goes back to the work (and to the checkpoint) that
+ * the phase came before */
+class IOPhaseStartTask: public AppTaskIO {
+public:
+    IOPhaseStartTask(Simulation *sim, simt_t _date, App* _app) :
+        AppTaskIO(sim, Task::IO_PHASE_START, _date, _app) {    }
+
+    ~IOPhaseStartTask() { }
+
+    bool vstep(void);
+};
+
 class IOEndTask: public AppTaskIO {
 public:
     IOEndTask(Simulation *sim, simt_t _date, App* _app) :
@@ -171,4 +219,16 @@ public:
     bool vstep(void);
 };
 
+/* End of a checkpoint copy that goes on in the background: the
+ * application does not wait for it, and traces do not see it */
+class DrainEndTask: public AppTaskIO {
+public:
+    DrainEndTask(Simulation *sim, simt_t _date, App* _app) :
+        AppTaskIO(sim, Task::DRAIN_END, _date, _app) {    }
+
+    ~DrainEndTask() { }
+
+    bool vstep(void);
+};
+
 #endif
@@ -3,19 +3,29 @@
 
 #include <deque>
 #include <tuple>
+#include <set>
+#include <memory>
+#include <stdio.h>
+#include <stdint.h>
+#include <zlib.h>
 
 #include "Simulation.h"
+#include "NodeSet.h"
 class Task;
+class System;
+class AppClass;
 
 class Trace
 {
 public:
     Trace() = default;
-    ~Trace() = default;
+    virtual ~Trace() = default;
     virtual const Trace &operator<<(const Task *task) {
         std::cout << *task << std::endl;
         return *this;
     }
+    /* A trace that has seen enough of the run can ask the simulation to stop */
+    virtual bool stop(void) const { return false; }
 };
 
 class EmptyTrace : public Trace
@@ -44,7 +54,13 @@ class PNGTrace : public Trace
     } event_t;
     std::vector<event_t>all_events;
     typedef struct {
-        std::vector<int> nodes;
+        simt_t date;
+        int first_node;
+        int nb_nodes;
+    } fault_t;
+    std::vector<fault_t>faults;   /* Drawn in white on the row of their date */
+    typedef struct {
+        NodeRanges nodes;
         png_byte r, g, b;
     } app_t;
     std::map<app_id_t, app_t>pmap;
@@ -57,9 +73,102 @@ public:
     PNGTrace &operator <<(const Task *task);
 };
 
+/** BinaryTrace
+ *    Writes the tasks to filename as fixed-size records, through a buffer,
+ *    deflated if compress is set, so that a TraceReplay can feed them to
+ *    other traces after the run. The nodes of each instance of an
+ *    application are written (as NODE_RANGE records) before its first task,
+ *    and the checkpoint level of a task (as a LEVEL record) before it.
+ *    Forwards the tasks to next, if any, and stops when next does.
+ */
+class BinaryTrace : public Trace
+{
+ public:
+    typedef struct {
+        char     magic[4];
+        uint32_t version;
+        uint32_t flags;
+        int32_t  nb_nodes;
+        int32_t  nb_levels;          /* Checkpoint levels below the file system */
+        int32_t  reserved;
+        double   overlap_slowdown;
+    } header_t;
+
+    typedef struct {
+        int64_t  date;            /* First node of the range for NODE_RANGE, checkpoint an APP_FAILURE restarts from for LEVEL */
+        int32_t  app_index;
+        int32_t  instance_index;  /* Number of nodes of a NODE_FAULT */
+        int32_t  value;           /* nb_nodes of the app, first node of a NODE_FAULT, number of nodes of the range, or io_level for LEVEL */
+        uint8_t  type;            /* Task::type_t, or NODE_RANGE */
+        uint8_t  r, g, b;
+    } record_t;
+
+    static const uint32_t VERSION = 3;
+    static const uint32_t COMPRESSED = 1;
+    static const uint8_t NODE_RANGE = 0xFF;
+    static const uint8_t LEVEL = 0xFE;
+    static const size_t BUFFER_RECORDS = 4096;
+
+ protected:
+    FILE *fp;
+    bool compress;
+    z_stream zs;
+    std::vector<record_t> buffer;
+    std::set<std::pair<int, int> > known_apps;
+    Trace *next;
+
+    void push(const record_t &r);
+    void flush(bool last);
+ public:
+    uint64_t nb_records;
+
+    BinaryTrace(const char *filename, const System *system, bool compress = false, Trace *next = nullptr);
+    ~BinaryTrace();
+
+    bool stop(void) const { return nullptr != next && next->stop(); }
+    BinaryTrace &operator <<(const Task *task);
+};
+
+/** TraceReplay
+ *    Reads a file written by a BinaryTrace (mapped in memory, or inflated
+ *    if it was compressed), and feeds its tasks, in order, to traces, as
+ *    the simulation did. The replayed applications belong to a class of a
+ *    system that has the overlap slowdown of the recorded one, and carry
+ *    its checkpoint levels.
+ */
+class TraceReplay
+{
+    const BinaryTrace::record_t *records;
+    size_t nb_records;
+    void *map;
+    size_t map_length;
+    std::vector<BinaryTrace::record_t> inflated;
+    std::unique_ptr<System> system;   /* Owns app_class */
+    AppClass *app_class;
+
+    void unmap(void);
+ public:
+    int nb_nodes;
+    int nb_levels;
+
+    TraceReplay(const char *filename);
+    ~TraceReplay();
+
+    size_t size(void) const { return nb_records; }
+    simt_t last_date(void) const;
+    uint64_t replay(Trace &t) const;
+};
+
 class StatTrace : public Trace
 {
-    typedef enum {LIMBO, WORK, CKPT, IO, WASTING} app_action_t ;
+ protected:
+    /* SNAPSHOT is the blocking part of an asynchronous checkpoint, until
+     * it is drained (then it is a CKPT); OVERLAP the work while it drains,
+     * recorded as WORK and as OVERLAP for what the slowdown costs.
+     * LEVEL_CKPT is a checkpoint below the file system, that some failures
+     * roll back beyond. IO_PHASE is an in-run I/O phase, recorded as IO
+     * and also aside. */
+    typedef enum {LIMBO, WORK, CKPT, IO, WASTING, SNAPSHOT, OVERLAP, LEVEL_CKPT, IO_PHASE} app_action_t ;
 
     typedef struct {
         int nb_nodes;
@@ -79,7 +188,14 @@ class StatTrace : public Trace
     double ignore_end;
     simt_t last_event;
     int nb_nodes;
+
+    virtual void record(const stat_event_t &ev);
+    virtual void waste(int app_id, simt_t since);
+    virtual void commit_snapshot(int app_id);
  public:
+    simt_t overlap;   /* Node.ms lost to the slowdown of asynchronous checkpoints, by the last getStat */
+    simt_t phase_io;  /* Node.ms of in-run I/O phases (part of the I/O), by the last getStat */
+
     StatTrace(int nb_nodes, double is = 0.1, double ie = 0.9) :
         Trace(),
         app_status(),
@@ -87,10 +203,12 @@ class StatTrace : public Trace
         ignore_start(is),
         ignore_end(ie),
         last_event(UNDEFINED_DATE),
-        nb_nodes(nb_nodes)
+        nb_nodes(nb_nodes),
+        overlap(0),
+        phase_io(0)
     { }
     
-    ~StatTrace() {}
+    virtual ~StatTrace() {}
 
     std::tuple<simt_t, simt_t, simt_t, simt_t, simt_t>getStat(simt_t intv_length, unsigned int seed);
 
@@ -99,5 +217,89 @@ class StatTrace : public Trace
     StatTrace &operator <<(const Task *task);
 };
 
+/** StreamStatTrace
+ *    Same accounting as StatTrace, but over measurement windows that are
+ *    fixed before the run, and accumulated as the events arrive instead of
+ *    keeping them all until getStat: only the work and I/O that each
+ *    running application did since its last checkpoint (that a failure
+ *    would turn into waste) are kept aside, window by window.
+ */
+class StreamStatTrace : public StatTrace
+{
+ protected:
+    typedef struct {
+        simt_t work;
+        simt_t io;
+        simt_t ckpt;
+        simt_t wasted;
+        simt_t overlap;
+        simt_t phase_io;
+    } usage_t;
+    typedef struct {
+        simt_t start;
+        simt_t end;
+        usage_t usage;
+    } window_t;
+    std::vector<window_t> windows;
+    simt_t window_length;
+    /* For each application, what it did since its last checkpoint that
+     * any failure leaves, in date order */
+    std::map<int, std::vector<stat_event_t> > pending;
+
+    template<typename F> void spread(const stat_event_t &ev, F f) const;
+    void account(const stat_event_t &ev, bool wasted);
+    void record(const stat_event_t &ev);
+    void waste(int app_id, simt_t since);
+    void commit(int app_id);
+    void commit_snapshot(int app_id);
+ public:
+    typedef std::tuple<simt_t, simt_t, simt_t, simt_t, simt_t> stat_t;
+    typedef std::tuple<double, double, double, double, double> summary_t;
+
+    StreamStatTrace(int nb_nodes, simt_t start, simt_t length, unsigned int nb_windows = 1);
+    ~StreamStatTrace() {}
+
+    virtual std::vector<stat_t> getStats(void) const;
+    std::vector<simt_t> getOverlaps(void) const;
+    std::vector<simt_t> getPhaseIOs(void) const;
+    static void summarize(const std::vector<stat_t> &stats, summary_t &mean, summary_t &half_width);
+    static double student95(unsigned int dof);
+
+    StreamStatTrace &operator <<(const Task *task);
+};
+
+/** ConvergenceMonitor
+ *    Splits the run in consecutive batches, and follows the waste ratio
+ *    (the part of the node time that is not work) of the batches as they
+ *    complete. Asks the simulation to stop once the 95% confidence interval
+ *    of the mean ratio is within tolerance of the mean, or once the running
+ *    mean stopped moving (steady state). A batch is taken as complete one
+ *    batch after its end, so that most of the failures that can still waste
+ *    its work happened.
+ */
+class ConvergenceMonitor : public StreamStatTrace
+{
+ protected:
+    double tolerance;
+    unsigned int min_batches;
+    unsigned int nb_complete;
+    std::vector<double> running_means;
+    bool stopped;
+
+    void complete_batch(void);
+ public:
+    std::string reason;
+    simt_t stop_date;
+
+    ConvergenceMonitor(int nb_nodes, simt_t start, simt_t batch_length, unsigned int max_batches,
+                       double tolerance, unsigned int min_batches = 5);
+    ~ConvergenceMonitor() {}
+
+    std::vector<stat_t> getStats(void) const;
+    double waste_ratio(const stat_t &st) const;
+    bool stop(void) const { return stopped; }
+
+    ConvergenceMonitor &operator <<(const Task *task);
+};
 
 #endif
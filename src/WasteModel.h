@@ -0,0 +1,59 @@
+#ifndef WasteModel_h
+#define WasteModel_h
+
+#include <stddef.h>
+#include <vector>
+
+class System;
+
+/** WasteModel
+ *    The closed-form waste of the paper (maple/celio.mpl), for the app
+ *    classes of a system. n_i apps of class i run at once, on q_i nodes
+ *    each, and write a checkpoint of C_i every P_i; with a node MTBF mu,
+ *    the fraction of the N nodes that is wasted is (Equation 7)
+ *      W = sum_i n_i q_i / N (C_i / P_i + q_i (P_i / 2 + C_i) / mu)
+ *    With Daly intervals, the P_i are the best ones for which the file
+ *    system writes one checkpoint at a time, sum_i n_i C_i / P_i <= 1
+ *    (Equation 6), that is (Equation 8)
+ *      P_i = sqrt(2 mu N (q_i / N + lambda) C_i) / q_i
+ *    for the smallest lambda >= 0 that meets the constraint. A fixed
+ *    interval that the file system cannot keep up with is stretched until
+ *    it can.
+ *    The classes get the share of the nodes they target (as the
+ *    simulations place them), and their checkpoints (full, as they are
+ *    written compressed) take C_i * bandwidth / bw at another bandwidth bw. Points are evaluated
+ *    BATCH at a time, in loops over the points that the compiler can
+ *    vectorize.
+ */
+class WasteModel {
+public:
+    typedef struct {
+        double nb_apps;   /* Running at once: n_i */
+        double nb_nodes;  /* Of one app: q_i */
+        double ckpt_time; /* At the bandwidth of the model, in seconds: C_i */
+    } class_t;
+
+    static const size_t BATCH = 256;
+    static const unsigned int NEWTON_STEPS = 12;
+
+    int nb_nodes;
+    double bandwidth;   /* Bytes/s */
+    double mtbf;        /* Of the system, in seconds */
+    double interval;    /* Seconds; 0: Daly */
+    std::vector<class_t> classes;
+
+    WasteModel(const System &system);
+
+    /* Waste at the point of the system */
+    double waste(void) const;
+    /* Waste at bandwidth bw, system MTBF mtbf (s) and checkpoint interval (s, 0: Daly) */
+    double waste(double bw, double mtbf, double interval) const;
+    /* Waste of the n points (bw[i], mtbf[i], interval[i]) into w */
+    void waste(const double *bw, const double *mtbf, const double *interval, double *w, size_t n) const;
+    /* Lowest bandwidth in [lo, hi] at which the waste is at most target,
+     * within a relative precision of precision; hi if there is none */
+    double bandwidth_for(double target, double mtbf, double interval, double lo, double hi,
+                         double precision = 1e-3) const;
+};
+
+#endif